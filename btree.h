@@ -0,0 +1,118 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include "index.h"
+#include "sort.h"
+
+// B+-tree index on a single INTEGER, FLOAT or STRING attribute. Like
+// the hash index it lives in its own file whose pages are accessed
+// through the buffer manager, with the header page pinned while the
+// index is open.
+//
+// Leaves hold (key, RID) entries and are chained left to right for
+// range scans. Entries are ordered on key and then RID, so duplicate
+// keys need no special handling and every entry has a unique place
+// in the tree. An interior node holds a first child followed by
+// (key, RID, child) entries; child i+1 holds the entries that are
+// greater than or equal to separator i.
+//
+// Deletes do not merge or redistribute nodes: a leaf may become
+// empty, the separators above it stay valid bounds.
+
+struct BTreeHdrPage
+{
+  int	attrOffset;             // offset of indexed attribute in a tuple
+  int	attrLen;                // length of indexed attribute
+  int	attrType;               // type of indexed attribute
+  int	rootPage;               // page number of the root node
+  int	height;                 // number of levels, 1 if root is a leaf
+  int	firstLeaf;              // page number of the leftmost leaf
+  int	entryCnt;               // number of entries in the index
+};
+
+const int BTREEPAGEHDR = 3 * sizeof(int);   // level, keyCnt, nextPage
+
+struct BTreePage
+{
+  int	level;                  // 0 for leaves
+  int	keyCnt;                 // number of entries on this page
+  int	nextPage;               // right neighbour on this level, -1 if none
+  char	data[MAXPAGESIZE - BTREEPAGEHDR];   // first PAGESIZE - BTREEPAGEHDR
+};                                          // bytes are used
+
+
+// create the file that holds an (empty) B+-tree index
+const Status createBTreeIndex(const string & relName,
+			      const int attrOffset,
+			      const int attrLen,
+			      const Datatype attrType);
+
+
+class BTreeIndex : public Index {
+ public:
+
+  // open the index on relName at attrOffset
+  BTreeIndex(const string & relName, const int attrOffset, Status & status);
+
+  // close the index
+  ~BTreeIndex();
+
+  // add / remove the entry (key, rid)
+  const Status insertEntry(const char* key, const RID & rid);
+  const Status deleteEntry(const char* key, const RID & rid);
+
+  // fill an empty tree bottom up from a file of (key, RID) records
+  // sorted on key
+  const Status bulkLoad(SortedFile & sorted);
+
+  // range scan: returns the RIDs of the entries whose key satisfies
+  // "key op value" in key order (NE is not supported)
+  const Status startScan(const char* value, const Operator op);
+  const Status scanNext(RID & outRid);  // NOMORERECS when done
+  const Status endScan();
+  const char* currentKey() const;
+
+  // return number of entries in the index
+  const int getEntryCnt() const;
+
+  // one page per level
+  const int probeCost() const;
+
+ private:
+  File*		filePtr;        // underlying DB File object
+  BTreeHdrPage*	headerPage;     // pinned index header page
+  int		headerPageNo;   // page number of header page
+  bool		hdrDirtyFlag;   // true if header page has been updated
+  int		entrySize;      // bytes per leaf entry (key, RID)
+  int		nodeEntrySize;  // bytes per interior entry (key, RID, child)
+  int		leafCap;        // entries per leaf
+  int		nodeCap;        // entries per interior node
+
+  char*		scanValue;      // value of the active scan, NULL if none
+  Operator	scanOp;         // operator of the active scan
+  BTreePage*	scanPage;       // leaf pinned by the scan
+  int		scanPageNo;     // its page number, -1 when the scan is done
+  int		scanSlot;       // next entry to look at
+
+  const int keyCmp(const char* key1, const char* key2) const;
+  const int entryCmp(const char* entry1, const char* entry2) const;
+  void copyKey(char* dest, const char* key) const;
+
+  char* leafEntry(BTreePage* page, const int i) const;
+  char* nodeEntry(BTreePage* page, const int i) const;
+  const int child(BTreePage* page, const int i) const;
+
+  const int upperBound(BTreePage* page, const char* entry) const;
+  const int lowerBound(BTreePage* page, const char* key) const;
+
+  const Status insertInto(const int pageNo, const char* entry,
+			  bool & split, char* sepEntry, int & newPageNo);
+  const Status splitLeaf(BTreePage* page, const int pos, const char* entry,
+			 char* sepEntry, int & newPageNo);
+  const Status splitNode(BTreePage* page, const int pos, const char* entry,
+			 char* sepEntry, int & newPageNo);
+  const Status addLevel(vector<char> & seps, vector<int> & pages,
+			const int level);
+};
+
+#endif
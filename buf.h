@@ -1,30 +1,75 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <vector>
+#include <mutex>
+#include <condition_variable>
 #include "db.h"
 // define if debug output wanted
 //#define DEBUGBUF
 
+const int PROBEHISTSIZE = 8;     // buckets of the probe length histogram
+
+struct BufStats
+{
+  int accesses;    // Total number of accesses to buffer pool (readPage calls)
+  int hits;        // accesses that found the page in the pool
+  int ringreuses;  // frames of the sequential ring given a new page
+  int mappedreads; // accesses served from a file's read-only mapping
+  int prefetches;  // pages announced to the kernel ahead of a scan
+  int prefetchhits;   // prefetched pages a readPage then missed on
+  int prefetchwasted; // prefetched pages nobody read while announced
+  int diskreads;   // Number of pages read from disk (including allocs)
+  int diskwrites;  // Number of pages written back to disk
+  int lookups;     // Number of buffer hash table lookups
+  int probes[PROBEHISTSIZE];  // lookups that looked at i+1 slots; the
+                              // last bucket also counts longer probes
+
+  void clear()
+    {
+      accesses = hits = ringreuses = mappedreads = diskreads = diskwrites = lookups = 0;
+      prefetches = prefetchhits = prefetchwasted = 0;
+      for (int i = 0; i < PROBEHISTSIZE; i++)
+        probes[i] = 0;
+    }
+      
+  BufStats()
+    {
+      clear();
+    }
+
+  double hitRatio() const
+    {
+      return accesses ? (double)hits / accesses : 0.0;
+    }
+};
+
+
 // declarations for buffer pool hash table
-struct hashBucket
+struct hashSlot
 {
-	File*	file;    // pointer a file object (more on this below)
+	File*	file;    // pointer a file object (more on this below), NULL if free
 	int	pageNo;  // page number within a file
 	int	frameNo; // frame number of page in the buffer pool
-	hashBucket* 	next;	 // next node in the hash table
 };
 
 
-// hash table to keep track of pages in the buffer pool
+// hash table to keep track of pages in the buffer pool. It is an open
+// addressing table with linear probing, kept in one array of slots
+// that is at most half full, so a lookup usually touches a single
+// cache line and inserts never allocate. Deletes shift the following
+// entries of the probe sequence back instead of leaving tombstones.
 class BufHashTbl
 {
 private:
-    int HTSIZE;
-    hashBucket**  ht; // actual hash table
-    int	 hash(const File* file, const int pageNo); // returns value between 0 and HTSIZE-1
+    unsigned int mask;   // number of slots - 1 (a power of two)
+    hashSlot*  ht;       // actual hash table
+    BufStats*  stats;    // where lookup probe lengths are counted, or NULL
+    unsigned int hash(const File* file, const int pageNo) const; // returns value between 0 and mask
+    int	 find(const File* file, const int pageNo, int & probes) const; // slot of entry or -1
 
 public:
-    BufHashTbl(const int htSize);  // constructor
+    BufHashTbl(const int maxEntries, BufStats* stats);  // constructor
     ~BufHashTbl(); // destructor
 	
     // insert entry into hash table mapping (file,pageNo) to frameNo;
@@ -43,10 +88,77 @@ public:
 
 
 class BufMgr;  //forward declaration of BufMgr class 
+class BufDesc;
+
+// How the caller is going to use a page. Pages read by a scan or
+// written to a temporary file are used once; they are loaded into a
+// small ring of frames that is recycled in turn, instead of pushing
+// the pages other queries keep coming back to out of the pool.
+enum BufHint {
+  RandomAccess,         // the page may well be asked for again
+  SequentialAccess,     // one of a run of pages read front to back
+  OnceAccess            // touched once; hits do not make it look hot
+};
+
+// the sequential ring holds this fraction of the pool
+const int RINGFRACTION = 8;
+
+// sequential scans read this many pages ahead; at most PREFETCHMAX
+// prefetched pages are remembered until they are read
+const int PREFETCHPAGES = 8;
+const int PREFETCHMAX = 4 * PREFETCHPAGES;
+
+// buffer replacement policies the buffer manager can be started with
+enum ReplPolicy { ClockRepl, LRUKRepl, TwoQRepl, ARCRepl };
+
+
+// Interface of a buffer replacement policy. The buffer manager tells
+// the policy about every page it finds or loads in a frame and about
+// frames that become free; when no frame is free it asks the policy
+// for a victim among the unpinned frames. Frames are numbered
+// 0..numBufs-1 and pages are named by (file, pageNo), which lets a
+// policy remember pages that are no longer in the pool.
+class BufPolicy
+{
+public:
+  virtual ~BufPolicy() {}
+
+  virtual const char* name() const = 0;
+
+  // page (file, pageNo) was found in frame (hit) or has just been
+  // loaded into it (!hit)
+  virtual void access(const int frame, const File* file, const int pageNo,
+		      const bool hit) = 0;
+
+  // frame no longer holds a page (file flushed or page disposed)
+  virtual void release(const int frame) = 0;
+
+  // choose an unpinned frame to hold page (file, pageNo); returns -1 if
+  // every frame is pinned. The victim's page is forgotten by the policy
+  // except for whatever history it keeps about evicted pages.
+  virtual int victim(const File* file, const int pageNo) = 0;
+
+  // true if somebody has the page in frame pinned, or the frame's page
+  // is being read or written back
+  bool pinned(const int frame) const;
+
+protected:
+  const BufDesc* bufTable;      // frames of the buffer manager
+  int numBufs;
+
+  BufPolicy(const BufDesc* table, const int bufs)
+    : bufTable(table), numBufs(bufs) {}
+};
+
+// create the policy kind for the frames of table
+BufPolicy* newBufPolicy(const ReplPolicy kind, const BufDesc* table,
+			const int bufs);
+
 
 // class for maintaining information about buffer pool frames
 class BufDesc {
     friend class BufMgr;
+    friend class BufPolicy;
 private:
   File* file;   // pointer to file object
   int   pageNo; // page within file
@@ -54,7 +166,7 @@ private:
   int   pinCnt; // number of times this page has been pinned
   bool 	dirty;	  // true if dirty;  false otherwise
   bool 	valid;   // true if page is valid
-  bool  refbit;	 // has this buffer frame been reference recently
+  bool	io;	 // true while the page is read or written back
 
   void Clear() {  // initialize buffer frame for a new user
     	pinCnt = 0;
@@ -62,6 +174,7 @@ private:
 	pageNo = -1;
     	dirty = false;
 	valid = false;
+	io = false;
   };
 
   void Set(File* filePtr, int pageNum) { 
@@ -70,7 +183,6 @@ private:
       pinCnt = 1;
       dirty = false;
       valid = true;
-      refbit = true;
   }
 
   BufDesc() {
@@ -79,55 +191,88 @@ private:
 };
 
 
-struct BufStats
-{
-  int accesses;    // Total number of accesses to buffer pool
-  int diskreads;   // Number of pages read from disk (including allocs)
-  int diskwrites;  // Number of pages written back to disk
-
-  void clear()
-    {
-      accesses = diskreads = diskwrites = 0;
-    }
-      
-  BufStats()
-    {
-      clear();
-    }
-};
-
-
 class BufMgr 
 {
 private:
-  unsigned int 	 clockHand;
   int   	 numBufs;    	// Number of pages in buffer pool
   BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
   BufStats	 bufStats;	// buffer pool statistics
+  BufPolicy*	 policy;	// picks the frame to replace
+  int*		 freeList;	// frames that hold no page
+  int		 freeCnt;	// number of entries in freeList
+  int*		 ring;		// frames of the sequential ring, -1 if none
+  int*		 ringSlot;	// position of each frame in ring, -1 if none
+  int		 ringSize;	// number of slots in ring
+  int		 ringNext;	// slot to recycle next
+  const File*	 prefetchFile[PREFETCHMAX]; // pages prefetched and not
+  int		 prefetchPage[PREFETCHMAX]; // read yet, oldest first
+  int		 prefetchCnt;
+  // Held by every public operation, so that the worker threads of a
+  // parallel operator can share the pool. It is let go of while
+  // readPage reads a page from disk and while a victim is written back,
+  // so the I/O of different threads overlaps; the frame is marked io
+  // meanwhile and a thread that wants its page waits on ioDone. The
+  // file extension of allocPage and the writes of flushFile still
+  // happen with the latch held.
+  mutable mutex	 latch;
+  condition_variable ioDone;    // signalled when a frame's io ends
 
-  const Status allocBuf(int & frame);   // allocate a free frame.  
+  // allocate a frame for page (file, pageNo): a free one if there is
+  // one, else the policy's victim, which is written back if dirty.
+  // unlocked is set if guard was let go of to write the victim.
+  const Status allocBuf(const File* file, const int pageNo, int & frame,
+			unique_lock<mutex> & guard, bool & unlocked);
+  // allocate a frame from the sequential ring, recycling the frame in
+  // the next slot if nobody has it pinned
+  const Status allocRingBuf(const File* file, const int pageNo, int & frame,
+			    unique_lock<mutex> & guard, bool & unlocked);
+  // write back and forget frame's page
+  const Status evictBuf(int frame, unique_lock<mutex> & guard,
+			bool & unlocked);
+  // write the listed frames back, runs of consecutive pages at once
+  const Status writeDirty(vector<hashSlot> & dirty);
+  hashSlot slotOf(const BufDesc* buf) const
+  {
+      hashSlot slot = { buf->file, buf->pageNo, buf->frameNo };
+      return slot;
+  }
   const void releaseBuf(int frame); // return unused frame to end of list
-  void advanceClock()
+  void leaveRing(int frame);        // take frame out of the ring
+  // forget that page pageNo of file was prefetched, or every page of
+  // file if pageNo is -1; returns true if one was found
+  bool dropPrefetch(const File* file, const int pageNo);
+  Page* framePage(const int frameNo) const // page held by a frame
   {
-	clockHand = (clockHand + 1) % numBufs;
+      return (Page*)(bufPool + (size_t)frameNo * PAGESIZE);
   }
 
-
 public:
-  Page*	         bufPool;   // actual buffer pool
+  char*	         bufPool;   // actual buffer pool, numBufs pages of PAGESIZE
 
-  BufMgr(const int bufs);
+  BufMgr(const int bufs, const ReplPolicy repl = ClockRepl);
   ~BufMgr();
 
-  const Status readPage(File* file, const int PageNo, Page*& page);
+  // pin page PageNo of file; a page of a file read through its mapping
+  // is handed out from there without being pinned (see File::mapped)
+  const Status readPage(File* file, const int PageNo, Page*& page,
+			const BufHint hint = RandomAccess);
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
-  const Status allocPage(File* file, int& PageNo, Page*& page); 
+  const Status allocPage(File* file, int& PageNo, Page*& page,
+			 const BufHint hint = RandomAccess); 
                         // allocates a new, empty page 
+  // start reading pages pageNo..pageNo+count-1 of file in the
+  // background; pages already in the pool are left out
+  void prefetchPages(File* file, const int pageNo, const int count);
   const Status flushFile(const File* file); // writing out all dirty pages of the file
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
   void  printSelf();
 
+  const int numUnpinnedPages() const; // frames not pinned by anybody
+  const int numFrames() const { return numBufs; } // size of the pool
+
+  const char* policyName() const { return policy->name(); }
+
   const BufStats & getBufStats() const // get buffer pool usage
   {
 	return bufStats;
@@ -1,6 +1,7 @@
 #ifndef CATALOG_H
 #define CATALOG_H
 
+#include <map>
 #include "heapfile.h"
 
 
@@ -56,6 +57,16 @@ class RelCatalog : public HeapFile {
   // destroy a relation
   const Status destroyRel(const string & relation);
 
+  // build an index of kind indexType (see index.h) on an attribute
+  // of a relation
+  const Status addIndex(const string & relation,
+			const string & attrName,
+			const int indexType,
+			const int numBuckets);
+
+  // drop the index on an attribute, or all indexes if attrName is empty
+  const Status dropIndex(const string & relation, const string & attrName);
+
   // print catalog information
   const Status help(const string & relation);          // relation may be NULL
 
@@ -70,6 +81,7 @@ class RelCatalog : public HeapFile {
 //   attribute number : integer(4)
 //   attribute type : integer(4)  (type is Datatype actually)
 //   attribute size : integer(4)
+//   indexed : integer(4)
 
 
 typedef struct {
@@ -78,6 +90,7 @@ typedef struct {
   int attrOffset;                       // attribute offset
   int attrType;                         // attribute type
   int attrLen;                          // attribute length
+  int indexed;                          // kind of index, 0 if none
 } AttrDesc;
 
 
@@ -99,6 +112,11 @@ class AttrCatalog : public HeapFile {
   // remove tuple from catalog
   const Status removeInfo(const string & relation, const string & attrName);
 
+  // set the kind of index of an attribute in place
+  const Status setIndexed(const string & relation,
+			  const string & attrName,
+			  const int indexed);
+
   // get all attributes of a relation
   const Status getRelInfo(const string & relation, 
 			  int &attrCnt, 
@@ -112,10 +130,63 @@ class AttrCatalog : public HeapFile {
 };
 
 
+// Cache of catalog information, keyed by relation name. An entry holds
+// the relcat tuple and all attrcat tuples of a relation; it is loaded
+// by the first lookup of the relation and thrown away whenever one of
+// those tuples is added, removed or updated, so lookups need not scan
+// the catalogs at all. Lookups of relations that do not exist are not
+// cached.
+
+struct CatStats
+{
+  int hits;        // lookups answered from the cache
+  int misses;      // lookups that had to scan relcat and attrcat
+
+  void clear()
+    {
+      hits = misses = 0;
+    }
+
+  CatStats()
+    {
+      clear();
+    }
+};
+
+
+class CatCache {
+ public:
+  // get the catalog information of a relation
+  const Status lookup(const string & relation,
+		      const RelDesc *& relDesc,
+		      const vector<AttrDesc> *& attrs);
+
+  // forget the cached information of a relation
+  void invalidate(const string & relation);
+
+  const CatStats & getCatStats() const // get cache usage
+  {
+	return catStats;
+  }
+  const void clearCatStats()
+  {
+	catStats.clear();
+  }
+
+ private:
+  struct CatEntry {
+    RelDesc rel;
+    vector<AttrDesc> attrs;             // in attrcat order
+  };
+
+  map<string, CatEntry> entries;
+  CatStats catStats;
+};
+
+
+extern CatCache    catCache;
 extern RelCatalog  *relCat;
 extern AttrCatalog *attrCat;
 extern Error error;
-extern Status createHeapFile(const string filename);
-extern Status destroyHeapFile(const string filename);
 
 #endif
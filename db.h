@@ -3,7 +3,9 @@
 
 #include <sys/types.h>
 #include <functional>
+#include <mutex>
 #include "error.h"
+#include "page.h"
 #include <string.h>
 using namespace std;
 
@@ -15,6 +17,16 @@ using namespace std;
 // forward class definition for db
 class DB;
 
+// structure of DB (header) page
+
+typedef struct {
+  int nextFree;                         // page # of next page on free list
+  int firstPage;                        // page # of first page in file
+  int numPages;                         // total # of pages in file
+  int pageSize;                         // bytes per page; 0 in files of
+                                        // the old page layout, refused
+} DBPage;
+
 // class definition for open files
 class File {
   friend class DB;
@@ -23,13 +35,44 @@ class File {
  public:
 
   Status allocatePage(int& pageNo);     // allocate a new page
+  Status allocatePages(const int count,
+		       int& firstPageNo);  // extend file by count pages
+  Status appendPages(const int pageNo, const int count,
+		     Page* const * pages); // extend file by pages given
+  const int endPage() const { return header.numPages; } // # of next
+                                        // page appended to the file
   const Status disposePage(const int pageNo);       // release space for a page
   const Status readPage(const int pageNo,
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status readPages(const int pageNo, const int count,
+		  Page* const * pages) const; // read consecutive pages
+  const Status writePages(const int pageNo, const int count,
+		  Page* const * pages);       // write consecutive pages
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
 
+  // page pageNo in the read-only mapping of the file, NULL if the file
+  // is not read through a mapping or the page lies beyond it
+  Page* mappedPage(const int pageNo) const
+    {
+      if (!map || written || pageNo < 1 || pageNo >= mapPages)
+	return NULL;
+      return (Page*)(map + (size_t)pageNo * PAGESIZE);
+    }
+
+  // true if page points into the mapping, i.e. it was handed out by
+  // mappedPage() rather than pinned in the buffer pool. Which of the
+  // two a page number gets depends on whether the file has been opened
+  // for writing since, so only the page's address tells.
+  bool mapped(const Page* page) const
+    {
+      return map && (const char*)page >= map
+	&& (const char*)page < map + (size_t)mapPages * PAGESIZE;
+    }
+  const Status prefetch(const int pageNo,
+		  const int count) const;     // announce reads of pages
+
   bool operator == (const File & other) const
     {
       return fileName == other.fileName;
@@ -43,13 +86,17 @@ class File {
   static const Status create(const string &fileName);
   static const Status destroy(const string &fileName);
 
-  const Status open();
+  const Status open(const bool readOnly, const bool useMap);
   const Status close();
+  const Status flushHeader();           // write header page if changed
 
   const Status intread(const int pageNo,
 		 Page* pagePtr) const;        // internal file read
   const Status intwrite(const int pageNo,
 		  const Page* pagePtr);       // internal file write
+  const Status intio(const int pageNo, const int count,
+		  Page* const * pages,
+		  const bool writing) const;  // internal vectored I/O
 
 #ifdef DEBUGFREE
   void listFree();                      // list free pages
@@ -58,6 +105,19 @@ class File {
   string fileName;                    // The name of the file
   int openCnt;                        // # times file has been opened
   int unixFile;                       // unix file stream for file
+  DBPage header;                      // header page, read on open
+  bool hdrDirty;                      // true if header has been changed
+
+  // A file opened read-only while nobody has it open for writing is
+  // mapped into memory, and the buffer manager hands out pointers into
+  // the mapping instead of copying pages into the pool. Once the file
+  // is opened for writing the mapping is no longer used for new reads;
+  // pages already handed out stay valid until the file is closed.
+  // Pages from the mapping are not pinned, so whoever got one must not
+  // unpin it; mapped() tells them apart.
+  char* map;                          // read-only mapping, NULL if none
+  int mapPages;                       // pages covered by map
+  bool written;                       // opened for writing since mapped
 };
 
 class BufMgr;
@@ -106,20 +166,27 @@ class DB {
   const Status createFile(const string & fileName) ;  // create a new file
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
-  const Status openFile(const string & fileName, File* & file);  // open a file
+  const Status openFile(const string & fileName, File* & file,
+			const bool readOnly = false);  // open a file
   const Status closeFile(File* file);         // close a file
 
+  // read files opened read-only through a memory mapping (off by
+  // default)
+  void setMapping(const bool on) { mapFiles = on; }
+
+  // Set the page size of the database; files are created with it and
+  // must have been created with it to be opened. Must be called
+  // before the buffer manager is created.
+  const Status setPageSize(const unsigned size);
+  // set the page size to the one recorded in file fileName
+  const Status usePageSizeOf(const string & fileName);
+
  private:
   OpenFileHashTbl   openFiles;    // list of open files
+  bool		    mapFiles;     // map files opened read-only
+  mutex		    latch;        // held while files are created,
+                                  // destroyed, opened or closed
 };
 
 
-// structure of DB (header) page
-
-typedef struct {
-  int nextFree;                         // page # of next page on free list
-  int firstPage;                        // page # of first page in file
-  int numPages;                         // total # of pages in file
-} DBPage;
-
 #endif
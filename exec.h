@@ -0,0 +1,145 @@
+#ifndef EXEC_H
+#define EXEC_H
+
+#include "catalog.h"
+#include "index.h"
+#include "sort.h"
+
+
+// Query plans are trees of iterators. open() gets an iterator ready,
+// each next() returns the following tuple of its output, FILEEOF when
+// there are no more, and close() lets go of everything it holds. An
+// iterator may be opened again after it has been closed, which starts
+// its output over. A tuple returned by next() stays valid until the
+// following call of next() or close(); tuples are handed up the tree
+// where they are, normally in a pinned page, so nothing is copied or
+// written to a temporary relation between operators.
+
+class QueryIter
+{
+public:
+  virtual ~QueryIter() {}
+
+  virtual const Status open() = 0;
+  virtual const Status next(Record & rec) = 0;
+  virtual const Status close() = 0;
+};
+
+
+// The tuples of a relation that satisfy a predicate (all tuples if
+// pred is NULL). The predicate is evaluated by the heap file scan on
+// each page as it is read. The iterator keeps a copy of pred, but not
+// of the values it compares with; those are read again by every
+// open(), so they may be changed while the iterator is closed.
+
+class ScanIter : public QueryIter
+{
+public:
+  ScanIter(const string & relation, const ScanPredicate* pred = NULL);
+  ~ScanIter();
+
+  const Status open();
+  const Status next(Record & rec);
+  const Status close();
+
+  // hand value, a comparison value of the predicate allocated with
+  // new [], over to the iterator, which deletes it
+  void own(char* value) { values.push_back(value); }
+
+private:
+  string relation;
+  ScanPredicate pred;
+  bool filtered;                // false if pred was NULL
+  vector<char*> values;         // owned comparison values
+  HeapFileScan* scan;           // NULL while closed
+  RecordBatch batch;            // qualifying tuples of the current page
+  int pos;                      // next tuple of batch
+};
+
+
+// The tuples of a relation whose attribute attr satisfies "attr op
+// key", found through the index on attr; the key is copied. If
+// indexOnly is true the tuples only hold attr, taken from the index
+// entries, and the relation itself is not read.
+
+class IndexScanIter : public QueryIter
+{
+public:
+  IndexScanIter(const AttrDesc & attr, const Operator op, const char* key,
+		const bool indexOnly);
+  ~IndexScanIter();
+
+  const Status open();
+  const Status next(Record & rec);
+  const Status close();
+
+private:
+  AttrDesc attr;
+  Operator op;
+  vector<char> key;
+  bool indexOnly;
+  Index* index;                 // NULL while closed
+  HeapFile* file;               // relation, unless indexOnly
+  char* keyRec;                 // tuple of an index only scan
+};
+
+
+// Projects the tuples of input onto attributes attrs[0..attrCnt-1],
+// which are copied one after the other into the output tuple.
+
+class ProjectIter : public QueryIter
+{
+public:
+  ProjectIter(QueryIter* input, const int attrCnt, const AttrDesc attrs[]);
+  ~ProjectIter();                     // deletes input
+
+  const Status open();
+  const Status next(Record & rec);
+  const Status close();
+
+private:
+  QueryIter* input;
+  vector<AttrDesc> attrs;
+  vector<char> outRec;
+};
+
+
+// The tuples of a relation in the order of one of its attributes,
+// sorted with SortedFile when the iterator is opened. maxItems,
+// maxFrames and threads are passed on to SortedFile. A position in the
+// output can be marked and gone back to later, as a merge join needs
+// to.
+
+class SortIter : public QueryIter
+{
+public:
+  SortIter(const AttrDesc & attr, const int maxItems,
+	   const int maxFrames = 0, const int threads = 1);
+  ~SortIter();
+
+  const Status open();
+  const Status next(Record & rec);
+  const Status close();
+
+  const Status setMark();       // remember the last tuple returned;
+  const Status gotoMark();      // go back so next() returns it again
+
+private:
+  AttrDesc attr;
+  int maxItems;
+  int maxFrames;
+  int threads;
+  SortedFile* sorted;           // NULL while closed
+};
+
+
+// Runs plan, inserting its tuples into relation result.
+const Status QU_Materialize(const string & result, QueryIter & plan);
+
+// Runs plan, printing its tuples like UT_Print prints a relation
+// called name; the tuples hold attributes attrs[0..attrCnt-1] one
+// after the other.
+const Status UT_Print(const string & name, const int attrCnt,
+		      const attrInfo attrs[], QueryIter & plan);
+
+#endif
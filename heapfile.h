@@ -6,6 +6,7 @@
 #include <iostream>
 #include <vector>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 #include "stdlib.h"
 using namespace std;
@@ -20,10 +21,23 @@ extern DB db;
 
 // Some constant definitions
 const unsigned MAXNAMESIZE = 50;
+const int MAXINDEXES = 16;       // max. number of indexes on a heap file
+const int LOADPAGES = 64;        // pages a bulk load appends at a time
 
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
 
+// A predicate kernel compares the n values of a column, vals, with
+// value and sets bit i % 64 of bits[i / 64] if value i satisfies the
+// predicate, clearing it otherwise. Integers and floats are packed
+// arrays; strings are length bytes each.
+typedef void (*FilterKernel)(const char* vals, const int n,
+			     const char* value, const int length,
+			     uint64_t* bits);
+
+// the kernel that evaluates "attribute op value" for attributes of type
+FilterKernel filterKernel(const Datatype type, const Operator op);
+
 struct FileHdrPage
 {
   char		fileName[MAXNAMESIZE];   // name of file
@@ -31,6 +45,50 @@ struct FileHdrPage
   int		lastPage;	// pageNo of last data page in file
   int		pageCnt;	// number of pages
   int		recCnt;		// record count
+  int		indexCnt;	// number of indexed attributes
+  int		indexOffset[MAXINDEXES];  // offsets of indexed attributes
+  int		indexType[MAXINDEXES];    // kinds of their indexes
+};
+
+class Index;
+
+
+// The predicate of a scan: a comparison "attribute op value", or the
+// AND or OR of other predicates. value points to a value of the
+// attribute's type; it must stay valid until the scan ends.
+struct ScanPredicate
+{
+  enum Kind { COMPARE, AND, OR };
+
+  Kind		kind;
+  int		offset;		// COMPARE: byte offset of attribute
+  int		length;		// length of attribute
+  Datatype	type;		// datatype of attribute
+  const char*	value;		// comparison value
+  Operator	op;		// comparison operator
+  vector<ScanPredicate> terms;	// AND, OR: the predicates combined
+
+  // set by HeapFileScan::startScan
+  FilterKernel	kernel;		// COMPARE: evaluates the comparison
+  double	selectivity;	// estimated fraction of records satisfying it
+
+  ScanPredicate(const Kind k = COMPARE)
+    : kind(k), offset(0), length(0), type(STRING), value(NULL), op(EQ),
+      kernel(NULL), selectivity(1.0) {}
+};
+
+
+// The records of one data page that satisfy the predicate of a scan,
+// as returned by HeapFileScan::scanNextBatch. The data pointers point
+// into the page, which stays pinned until the scan moves on to
+// another page or ends.
+struct RecordBatch
+{
+  int		count;		// number of records in the batch
+  vector<RID>	rid;		// rid[i] and rec[i], 0 <= i < count,
+  vector<Record> rec;		// are the records of the batch
+
+  RecordBatch() : count(0) {}
 };
 
 
@@ -46,11 +104,32 @@ protected:
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
    RID   	curRec;         // rid of last record returned
+   BufHint	accessHint;     // how data pages are read by scans
+
+   vector<Index*> indexes;      // open indexes, one per indexOffset[]
+   bool		indexesOpen;    // true once indexes has been filled in
+
+   // open the indexes listed in the header page, if not done yet
+   const Status openIndexes();
+
+   // add / remove the index entries for a record
+   const Status insertIndexEntries(const Record & rec, const RID & rid);
+   const Status deleteIndexEntries(const Record & rec, const RID & rid);
+
+   // close the open indexes
+   void closeIndexes();
+
+   // unpin page pageNo, which was read as page; a page read from the
+   // file's mapping was not pinned and is left alone
+   const Status releasePage(const int pageNo, const Page* page,
+			    const bool dirty);
 
 public:
 
-  // initialize
-  HeapFile(const string & name, Status& returnStatus);
+  // initialize; a file opened readOnly may be read through a memory
+  // mapping and none of its pages can be changed
+  HeapFile(const string & name, Status& returnStatus,
+	   const bool readOnly = false);
 
   // destructor
   ~HeapFile();
@@ -58,8 +137,21 @@ public:
   // return number of records in file
   const int getRecCnt() const;
 
+  // return number of data pages in file
+  const int getPageCnt() const;
+
   // given a RID, read record from file, returning pointer and length
   const Status getRecord(const RID &rid, Record & rec);
+
+  // hand each record of data page i, 0 <= i < getPageCnt(), to fcn;
+  // the page of a scan of the file stays where it is
+  const Status readDataPage(const int i,
+			    const function<void (const Record & rec)> & fcn);
+
+  // record / forget an index of kind type on the attribute at offset
+  // in the header
+  const Status addIndex(const int offset, const int type);
+  const Status removeIndex(const int offset);
 };
 
 
@@ -67,7 +159,8 @@ class HeapFileScan : public HeapFile
 {
 public:
 
-    HeapFileScan(const string & name, Status & status);
+    HeapFileScan(const string & name, Status & status,
+		 const bool readOnly = false);
 
     // end filtered scan
     ~HeapFileScan();
@@ -78,6 +171,12 @@ public:
                            const char* filter, 
                            const Operator op);
 
+    // start a scan returning the records that satisfy pred. The terms
+    // of every AND are evaluated most selective first and those of
+    // every OR least selective first, so that a page is done with as
+    // soon as possible.
+    const Status startScan(const ScanPredicate & pred);
+
     const Status endScan(); // terminate the scan
     const Status markScan(); // save current position of scan
     const Status resetScan(); // reset scan to last marked location
@@ -85,6 +184,12 @@ public:
     // return RID of next record that satisfies the scan 
     const Status scanNext(RID& outRid);
 
+    // return the records that satisfy the scan on the rest of the
+    // current page, or on the next page that has any; returns FILEEOF
+    // when there are none left. The last record of that page becomes
+    // the current record.
+    const Status scanNextBatch(RecordBatch & batch);
+
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
@@ -95,11 +200,8 @@ public:
     const Status markDirty();
 
 private:
-    int   offset;            // byte offset of filter attribute
-    int   length;            // length of filter attribute
-    Datatype type;           // datatype of filter attribute
-    const char* filter;      // comparison value of filter
-    Operator op;             // comparison operator of filter
+    ScanPredicate pred;      // predicate of the scan
+    bool  filtered;          // false if every record qualifies
 
      // The following variables are used to preserve the state
     // of the scan when the method markScan() is invoked.
@@ -108,21 +210,76 @@ private:
     int   markedPageNo;	// page number of pinned page
     RID   markedRec;         // rid of last record returned
 
-    const bool matchRec(const Record & rec) const;
+    // The predicate is evaluated for all records of a page at once,
+    // the first time a record of the page is asked for. match has a
+    // bit per slot of page matchPage, set if the record in the slot
+    // satisfies the predicate.
+    int   matchPage;         // page match belongs to, -1 if none
+    int   pageSlots;         // number of slots of matchPage
+    vector<uint64_t> match;  // selection bitmap of matchPage
+    vector<uint64_t> present;   // slots of matchPage that hold a record
+    vector<vector<uint64_t> > scratch;  // bitmaps of terms, by depth
+    vector<char> column;     // compared attribute of each slot
+    RecordBatch pageRecs;    // records of the page being evaluated
+
+    void evalPage();         // fill match for the current page
+    // set bits to the slots whose records satisfy p; depth is the
+    // depth of p in the predicate tree
+    void evalPred(const ScanPredicate & p, uint64_t* bits, const int depth);
+    const bool matchSlot(const int slotNo)  // record in slot qualifies?
+    {
+        if (!filtered) return true;
+        if (matchPage != curPageNo) evalPage();
+        return (match[slotNo / 64] >> (slotNo % 64)) & 1;
+    }
+    void readAhead();        // prefetch the pages after the current one
 };
 
 
+// create / destroy the file that holds a heap file
+const Status createHeapFile(const string fileName);
+const Status destroyHeapFile(const string fileName);
+
+
 class InsertFileScan : public HeapFile
 {
 public:
 
-    InsertFileScan(const string & name, Status & status);
+    // hint is how the pages the records go to are used afterwards,
+    // OnceAccess for temporary files that are written out and read
+    // back later
+    InsertFileScan(const string & name, Status & status,
+		   const BufHint hint = RandomAccess);
 
     // end filtered scan
     ~InsertFileScan();
 
     // insert record into file, returning its RID
     const Status insertRecord(const Record & rec, RID& outRid); 
+
+    // Bulk load: insert count records of width bytes each, stored one
+    // after the other at recs. The rest of the last page is filled,
+    // then new pages are formatted in memory and appended to the file
+    // LOADPAGES at a time without going through the buffer pool. The
+    // header page is brought up to date once, by endLoad(); any other
+    // operation on the file ends the load first.
+    const Status loadRecords(const char* recs, const int count,
+			     const int width);
+    const Status endLoad();
+
+private:
+    bool	loading;	// true between loadRecords() and endLoad()
+    vector<char> loadBuf;	// pages being formatted, PAGESIZE each
+    int		loadFirst;	// page number of the first of them
+    int		loadCnt;	// number of pages started in loadBuf
+    int		loadPages;	// pages appended to the file so far
+    int		loadRecs;	// records loaded so far
+
+    Page* loadPage(const int i)	// page i of loadBuf
+    {
+	return (Page*)&loadBuf[(size_t)i * PAGESIZE];
+    }
+    const Status writeLoad();	// append the pages of loadBuf to the file
 };
 
 #endif
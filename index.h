@@ -0,0 +1,152 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include "heapfile.h"
+
+// define if debug output wanted
+//#define DEBUGIND
+
+// Kinds of index. The kind of an attribute's index is kept in the
+// indexed column of attrcat (0 if there is none) and in the header
+// page of the relation's heap file.
+
+enum IndexType { HASHINDEX = 1, BTREEINDEX = 2 };
+
+
+// Operations common to all kinds of index. Each attribute has at
+// most one index, stored in the file indexFileName(relName, offset).
+
+class Index {
+ public:
+  virtual ~Index() {}
+
+  // add / remove the entry (key, rid)
+  virtual const Status insertEntry(const char* key, const RID & rid) = 0;
+  virtual const Status deleteEntry(const char* key, const RID & rid) = 0;
+
+  // scan for the entries whose key satisfies "key op value"
+  virtual const Status startScan(const char* value, const Operator op) = 0;
+  virtual const Status scanNext(RID & outRid) = 0;  // NOMORERECS when done
+  virtual const Status endScan() = 0;
+
+  // key of the entry last returned by scanNext (for index-only scans)
+  virtual const char* currentKey() const = 0;
+
+  // return number of entries in the index
+  virtual const int getEntryCnt() const = 0;
+
+  // pages read by one equality probe
+  virtual const int probeCost() const = 0;
+};
+
+
+// true if an index of kind type can evaluate "key op value"
+const bool indexSupports(const int type, const Operator op);
+
+// open the index of kind type on relName at attrOffset
+Index* openIndex(const string & relName, const int attrOffset,
+		 const int type, Status & status);
+
+// name of the file holding the index on relName at attrOffset
+const string indexFileName(const string & relName, const int attrOffset);
+
+// destroy the file that holds an index of either kind
+const Status destroyIndex(const string & relName, const int attrOffset);
+
+
+// Extendible hash index on a single attribute of a relation.  The
+// index lives in its own file, named after the relation and the
+// offset of the indexed attribute, and every page of it (header,
+// directory and buckets) is accessed through the buffer manager.
+//
+// The header page stays pinned while the index is open and holds the
+// page numbers of the directory pages, so nothing about the index is
+// cached outside the buffer pool.  A bucket whose entries all share
+// the same hash value cannot be split; it grows a chain of overflow
+// pages instead.
+
+// The directory is laid out for the smallest page size, so that its
+// shape does not depend on the page size of the database.
+const int DIRPAGEENTRIES = MINPAGESIZE / sizeof(int);   // bucket ptrs per page
+const int MAXDIRPAGES = (MINPAGESIZE - 6 * sizeof(int)) / sizeof(int);
+const int MAXDEPTH = 15;        // 2^MAXDEPTH <= MAXDIRPAGES*DIRPAGEENTRIES
+
+struct IndexHdrPage
+{
+  int	attrOffset;             // offset of indexed attribute in a tuple
+  int	attrLen;                // length of indexed attribute
+  int	attrType;               // type of indexed attribute
+  int	globalDepth;            // directory has 2^globalDepth entries
+  int	entryCnt;               // number of entries in the index
+  int	dirPageCnt;             // number of directory pages
+  int	dirPage[MAXDIRPAGES];   // page numbers of the directory pages
+};
+
+const int BUCKETPAGEHDR = 3 * sizeof(int);  // localDepth, slotCnt, nextPage
+
+struct BucketPage
+{
+  int	localDepth;             // number of hash bits this bucket owns
+  int	slotCnt;                // number of entries on this page
+  int	nextPage;               // next overflow page, -1 if none
+  char	data[MAXPAGESIZE - BUCKETPAGEHDR];  // (key, RID) entries, in
+};                                          // PAGESIZE - BUCKETPAGEHDR bytes
+
+
+// create the file that holds a hash index
+const Status createHashIndex(const string & relName,
+			     const int attrOffset,
+			     const int attrLen,
+			     const Datatype attrType,
+			     const int numBuckets);
+
+
+class HashIndex : public Index {
+ public:
+
+  // open the index on relName at attrOffset
+  HashIndex(const string & relName, const int attrOffset, Status & status);
+
+  // close the index
+  ~HashIndex();
+
+  // add / remove the entry (key, rid)
+  const Status insertEntry(const char* key, const RID & rid);
+  const Status deleteEntry(const char* key, const RID & rid);
+
+  // equality scan: returns the RIDs of all entries whose key is value
+  const Status startScan(const char* value, const Operator op);
+  const Status scanNext(RID & outRid);  // NOMORERECS when done
+  const Status endScan();
+  const char* currentKey() const;
+
+  // return number of entries in the index
+  const int getEntryCnt() const;
+
+  // a directory page and a bucket page
+  const int probeCost() const;
+
+ private:
+  File*		filePtr;        // underlying DB File object
+  IndexHdrPage*	headerPage;     // pinned index header page
+  int		headerPageNo;   // page number of header page
+  bool		hdrDirtyFlag;   // true if header page has been updated
+  int		entrySize;      // bytes per (key, RID) entry
+  int		bucketCap;      // entries per bucket page
+
+  char*		scanKey;        // key of the active scan, NULL if none
+  BucketPage*	scanPage;       // bucket page pinned by the scan
+  int		scanPageNo;     // its page number
+  int		scanSlot;       // next entry to look at
+
+  const unsigned int hashKey(const char* key) const;
+  const bool keyMatch(const char* key1, const char* key2) const;
+  void copyKey(char* dest, const char* key) const;
+
+  const Status getDirEntry(const int i, int & pageNo);
+  const Status setDirEntry(const int i, const int pageNo);
+  const Status doubleDirectory();
+  const Status splitBucket(const unsigned int hash);
+};
+
+#endif
@@ -18,14 +18,23 @@ struct Record
 
 // slot structure
 struct slot_t {
-        short	offset;  
-        short	length;  // equals -1 if slot is not in use
+        int	offset;  
+        int	length;  // equals -1 if slot is not in use
 };
 
-const unsigned PAGESIZE = 1024;
-const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
-const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
-// size of the data area of a page
+// The page size is chosen when a database is created (dbcreate) and
+// recorded in the header page of each of its files. PAGESIZE is set
+// from it before the buffer manager is created, and is a power of two
+// between MINPAGESIZE and MAXPAGESIZE.
+const unsigned MINPAGESIZE = 1024;
+const unsigned MAXPAGESIZE = 65536;
+extern unsigned PAGESIZE;
+
+// true if size can be used as a page size
+bool validPageSize(const unsigned size);
+
+const unsigned DPHDRSIZE = 6*sizeof(int);    // page header in front of data[]
+const unsigned DPFIXED= sizeof(slot_t)+DPHDRSIZE;
 
 // Class definition for a minirel data page.   
 // The design assumes that records are kept compacted when
@@ -33,17 +42,34 @@ const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
 // array cannot be compacted.  Notice, this class does not keep
 // the records align, relying instead on upper levels to take
 // care of non-aligned attributes
+//
+// A page occupies PAGESIZE bytes: the header, then the records growing
+// up from the start of data[], then the slot array growing down from
+// the end of the page. The class is declared MAXPAGESIZE bytes long
+// but only the first PAGESIZE bytes of a page are ever used, so it is
+// only laid over memory of PAGESIZE bytes through pointers; no Page
+// object is ever created.
 
 class Page {
 private:
-    char 	data[PAGESIZE - DPFIXED]; 
-    slot_t 	slot[1]; // first element of slot array - grows backwards!
-    short	slotCnt; // number of slots in use;
-    short	freePtr; // offset of first free byte in data[]
-    short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    Page();                         // not to be created or copied
+    Page(const Page &);
+    Page & operator=(const Page &);
+
+    int		slotCnt; // number of slots in use;
+    int		freePtr; // offset of first free byte in data[]
+    int		freeSpace; // number of bytes free in data[]
+    int		dummy;	// for alignment purposes
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
+    char 	data[MAXPAGESIZE - DPHDRSIZE]; 
+
+    // element i of the slot array; slot(0) is the last slot_t of the
+    // page and the array grows backwards, so i is 0 or negative
+    slot_t& slot(const int i) const
+    {
+        return ((slot_t*)((char*)this + PAGESIZE))[i - 1];
+    }
 
 public:
     void init(const int pageNo); // initialize a new page
@@ -51,11 +77,16 @@ public:
 
     const Status getNextPage(int& pageNo) const; // returns value of nextPage
     const Status setNextPage(const int pageNo); // sets value of nextPage to pageNo
-    const short getFreeSpace() const; // returns amount of free space
+    const int getFreeSpace() const; // returns amount of free space
 
     // inserts a new record (rec) into the page, returns RID of record 
     const Status insertRecord(const Record & rec, RID& rid);
 
+    // appends as many as fit of the count records of width bytes each
+    // stored one after the other at recs, with new slots; returns the
+    // number appended, which get slot numbers getSlotCnt() on
+    const int fill(const char* recs, const int count, const int width);
+
     // delete the record with the specified rid
     const Status deleteRecord(const RID & rid);
 
@@ -69,6 +100,14 @@ public:
 
     // returns reference to record with RID rid
     const Status getRecord(const RID & rid, Record & rec);
+
+    // number of entries of the slot array, in use or not
+    const int getSlotCnt() const { return -slotCnt; }
+
+    // returns RIDs of and references to the records in the slots after
+    // slot slotNo (-1 for all of them), in slot order, and their number;
+    // rids and recs need room for getSlotCnt() entries
+    const int getRecords(const int slotNo, RID rids[], Record recs[]);
 };
 
 #endif
@@ -65,7 +65,10 @@ typedef enum {
     N_ATTRTYPE,
     N_VALUE,
     N_LIST,
-    N_ALIAS
+    N_ALIAS,
+    N_AND,
+    N_OR,
+    N_NOT
 } NODEKIND;
 
 
@@ -112,6 +115,7 @@ typedef struct node {
 	struct {
 	    char *relname;
 	    char *attrname;
+	    char *indextype;		// "hash" or "btree", NULL for hash
 	    int nbuckets;
 	} BUILD;
 
@@ -151,6 +155,12 @@ typedef struct node {
 	    struct node *joinattr2;
 	} JOIN;
 
+	// and, or, not node; right is NULL for not */
+	struct {
+	    struct node *left;
+	    struct node *right;
+	} LOGIC;
+
 	// qualified attribute node */
 	struct {
 	    char *relname;
@@ -217,7 +227,8 @@ NODE *insert_node(char *relname, NODE *attrlist);
 NODE *delete_node(char *relname, NODE *qual);
 NODE *create_node(char *relname, NODE *attrlist, NODE *primattr);
 NODE *destroy_node(char *relname);
-NODE *build_node(char *relname, char *attrname, int nbuckets);
+NODE *build_node(char *relname, char *attrname, char *indextype,
+		 int nbuckets);
 NODE *rebuild_node(char *relname, char *attrname, int nbuckets);
 NODE *drop_node(char *relname, char *attrname);
 NODE *load_node(char *relname, char *filename);
@@ -225,6 +236,7 @@ NODE *print_node(char *relname);
 NODE *help_node(char *relname);
 NODE *select_node(NODE *selattr, int op, NODE *value);
 NODE *join_node(NODE *joinattr1, int op, NODE *joinattr2);
+NODE *logic_node(int kind, NODE *left, NODE *right);
 NODE *qualattr_node(char *relname, char *attrname);
 NODE *primattr_node(char *attrname, int nbuckets);
 NODE *attrval_node(char *attrname, NODE *value);
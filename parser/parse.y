@@ -85,9 +85,7 @@ static NODE *parse_tree;                // root of parse tree
 		create
 		destroy
 		build
-/*
 		rebuild
-*/
 		drop
 		load
 		print
@@ -96,6 +94,9 @@ static NODE *parse_tree;                // root of parse tree
 		opt_primary_attr
 		opt_where
 		qual
+		cond
+		conj
+		factor
 		selection
 		join
 		non_mt_qualattr_list
@@ -148,9 +149,7 @@ command
 	| create
 	| destroy
 	| build
-/*
 	| rebuild
-*/
 	| drop
 	| load
 	| print
@@ -272,18 +271,28 @@ destroy
 build
 	: RW_BUILD string '(' string ')'
 	{
-		$$ = build_node($2, $4, 0);
+		$$ = build_node($2, $4, NULL, 0);
+	}
+	| RW_BUILD string '(' string ')' RW_NUMBUCKETS T_EQ T_INT
+	{
+		$$ = build_node($2, $4, NULL, $8);
+	}
+	| RW_BUILD string '(' string ')' RW_AS string
+	{
+		$$ = build_node($2, $4, $7, 0);
+	}
+	| RW_BUILD string '(' string ')' RW_AS string RW_NUMBUCKETS T_EQ T_INT
+	{
+		$$ = build_node($2, $4, $7, $10);
 	}
 	;
 
-/*
 rebuild
 	: RW_REBUILD string '(' string ')' RW_NUMBUCKETS T_EQ T_INT
 	{
 		$$ = rebuild_node($2, $4, $8);
 	}
 	;
-*/
 
 drop
 	: RW_DROP string '(' string ')'
@@ -368,10 +377,38 @@ opt_where
 	;
 
 qual
-	: selection
+	: cond
 	| join
 	;
 
+cond
+	: cond RW_OR conj
+	{
+		$$ = logic_node(N_OR, $1, $3);
+	}
+	| conj
+	;
+
+conj
+	: conj RW_AND factor
+	{
+		$$ = logic_node(N_AND, $1, $3);
+	}
+	| factor
+	;
+
+factor
+	: selection
+	| '(' cond ')'
+	{
+		$$ = $2;
+	}
+	| RW_NOT factor
+	{
+		$$ = logic_node(N_NOT, $2, NULL);
+	}
+	;
+
 selection
 	: qualattr op value
 	{
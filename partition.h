@@ -4,6 +4,11 @@
 #include "heapfile.h"
 
 
+// Hash function of a partitioning: the partition 0..P-1 of record
+// rec. A function object can carry what it needs to know, such as the
+// attribute that is hashed.
+typedef function<int (const Record & rec, const int P)> PartitionHash;
+
 // define if debug output wanted
 //#define DEBUGPART
 
@@ -13,16 +18,14 @@ class Partition {
   Partition(HeapFileScan *rel,              // name of heap file to partition
 	    const string & fileName,             // (base) name of heap file
 	    const int P,                      // number of partitions
-	    const int (*hashfcn)(const Record & rec,
-				 const int P),  
-	                               // hash function to use in partitioning
+	    const PartitionHash & hashfcn,  // hash function to use in partitioning
 	    string* &partName,           // names of partitioned heap files
 	    Status &status);            // create partitions of file
   ~Partition();                         // destroy partitions
 
  private:
 
-  int P;                                // number of partitions
+  int P;                                // partition files created
   string *partName;                      // partition names
 };
 
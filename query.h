@@ -3,11 +3,33 @@
 
 #include "heapfile.h"
 
-enum JoinType {NLJoin, SMJoin, HashJoin};
+// AutoJoin picks one of the others per query with a cost model
+enum JoinType {NLJoin, SMJoin, HashJoin, BNLJoin, INLJoin, AutoJoin};
+
+// The where clause of a selection: a comparison "attr op attrValue",
+// attrValue given as text like the value of QU_Select, or the and / or
+// of other conditions
+struct Condition
+{
+  enum Kind { COMPARE, AND, OR };
+
+  Kind		kind;
+  attrInfo	attr;		// COMPARE: attribute and value compared
+  Operator	op;		// comparison operator
+  vector<Condition> terms;	// AND, OR: the conditions combined
+
+  Condition(const Kind k = COMPARE) : kind(k), op(EQ) {}
+};
+
+class QueryIter;
 
 //
 // Prototypes for query layer functions
 //
+// QU_Select, QU_SelectWhere and QU_Join insert the result of the
+// query into relation result. The ...Plan versions return the plan of
+// the query instead (see exec.h); the caller runs and deletes it.
+//
 
 
 const Status QU_Select(const string & result, 
@@ -17,6 +39,11 @@ const Status QU_Select(const string & result,
 		       const Operator op, 
 		       const char *attrValue);
 
+const Status QU_SelectWhere(const string & result, 
+			    const int projCnt, 
+			    const attrInfo projNames[],
+			    const Condition & where);
+
 const Status QU_Join(const string & result, 
 		     const int projCnt, 
 		     const attrInfo projNames[],
@@ -24,6 +51,25 @@ const Status QU_Join(const string & result,
 		     const Operator op, 
 		     const attrInfo *attr2);
 
+const Status QU_SelectPlan(const int projCnt, 
+			   const attrInfo projNames[],
+			   const attrInfo *attr, 
+			   const Operator op, 
+			   const char *attrValue,
+			   QueryIter *&plan);
+
+const Status QU_SelectWherePlan(const int projCnt, 
+				const attrInfo projNames[],
+				const Condition & where,
+				QueryIter *&plan);
+
+const Status QU_JoinPlan(const int projCnt, 
+			 const attrInfo projNames[],
+			 const attrInfo *attr1, 
+			 const Operator op, 
+			 const attrInfo *attr2,
+			 QueryIter *&plan);
+
 const Status QU_Insert(const string & relation, 
 		       const int attrCnt, 
 		       const attrInfo attrList[]);
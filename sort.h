@@ -1,63 +1,219 @@
 #ifndef SORT_H
 #define SORT_H
 
+#include <algorithm>
+#include <mutex>
 #include "heapfile.h"
 
 // define if debug output wanted
 //#define DEBUGSORT
 
 
-// SORTREC is an in-memory sort record that qsort(3) sorts.
-// The sort attribute as well as the associated RID are
-// stored in the record. The RID is used for fetching the
-// full record when it is needed.
+// SORTREC is an in-memory sort record. It refers to a copy of a
+// whole record of the source file kept in the sort buffer, so that
+// the record never has to be fetched again to be written to a run.
+// key is the normalized key of the sort attribute (see sort.C),
+// which most comparisons need look at only. While runs are
+// generated, run is the number of the run the record goes to.
 
 typedef struct {
-  RID rid;                              // record id of current record
-  char* field;                          // pointer to field
-  int length;                           // length of field
+  uint64_t key;                         // normalized sort key
+  char* data;                           // copy of the record
+  int recLen;                           // length of the record
+  int run;                              // run the record belongs to
 } SORTREC;
 
 
-class SortedFile {
+// A tournament tree of losers over players 0..k-1, which picks the
+// smallest of k items again and again. Inner node n holds the player
+// that lost the match played there; node 0 holds the overall winner.
+// Player i is leaf k+i, so the tree works for any k >= 1. before(a, b)
+// tells whether player a must come out ahead of player b. When the
+// item of the winner is replaced, only the matches on the path from
+// its leaf to the root are played again, about log2(k) comparisons.
+
+template <class Before>
+class LoserTree {
  public:
-  SortedFile(const string & fileName, 
-	     int offset,// sort source file on the given
-	     int length, Datatype type, // attribute
-	     int maxItems, Status& status);
+  LoserTree(const Before & before) : k(0), before(before) {}
+
+  int winner() const { return node[0]; }
+
+  // play every match among players 0..players-1
+  void build(const int players)
+  {
+    k = players;
+    node.assign(k > 1 ? k : 1, 0);
+    vector<int> win(2 * k);             // winner of the match at a node
+    for (int i = 0; i < k; i++)
+      win[k + i] = i;
+    for (int n = k - 1; n >= 1; n--) {
+      int a = win[2 * n], b = win[2 * n + 1];
+      if (before(b, a)) { win[n] = b; node[n] = a; }
+      else { win[n] = a; node[n] = b; }
+    }
+    node[0] = (k > 1) ? win[1] : 0;
+  }
+
+  // the item of player (the winner) has changed
+  void replay(int player)
+  {
+    for (int n = (k + player) / 2; n >= 1; n /= 2)
+      if (before(node[n], player))
+	swap(node[n], player);
+    node[0] = player;
+  }
+
+ private:
+  int k;                                // number of players
+  vector<int> node;                     // losers, node[0] the winner
+  Before before;
+};
+
+
+class SortedFile;
+
+
+// A part of a sort: the records of the source file whose keys fall in
+// one range, or all of them if the sort is not parallel. They are
+// kept in memory if they fit in the part's buffer of maxItems records;
+// else they are distributed over sorted runs by replacement selection,
+// which next() merges.
+
+class SortPart {
+ public:
+  SortPart(const SortedFile* sf, int maxItems);
+  ~SortPart();                          // destroys the run files
+
+  Status add(const Record & rec);       // copy in the next record
+  Status finish();                      // all records have been added
+  Status reduce(unsigned maxRuns, int frames); // merge runs in passes
+  Status startScans();                  // start a scan on each sorted run
 
   Status next(Record & rec);            // fetch next record in sort order
   Status setMark();                     // record a position in sort sequence
   Status gotoMark();                    // go to last recorded spot
-  ~SortedFile();                        // destroy temporary structures / files
+  Status rewind();                      // go back to the first record
 
- private:
-  Status sortFile();                    // split source file into sub-runs
-  Status generateRun(int numItems);     // generate one sub-run of file
-  Status startScans();                  // start a scan on each sorted run
+  int count() const { return numItems; } // # of items in buffer
+  Record record(int i) const            // record of item i
+  {
+    Record rec;
+    rec.data = buffer[i].data;
+    rec.length = buffer[i].recLen;
+    return rec;
+  }
 
+ private:
   typedef struct {
     string name;                        // name of run file
     HeapFileScan* inFile;               // ptr to input file
-    InsertFileScan* outFile;		// ptr to output file
     int valid;                          // TRUE if recPtr has a record
     Record rec;
+    uint64_t key;                       // normalized key of rec
     RID rid;                            // RID of current record of run
     RID mark;
   } RUN;
 
+  // order of the runs being merged by their current record; runs
+  // that have ended come last
+  struct MergeOrder {
+    const SortPart* part;
+    MergeOrder(const SortPart* part) : part(part) {}
+    bool operator()(const int a, const int b) const;
+  };
+
+  // order of the items of the buffer during replacement selection:
+  // by run first, then by key
+  struct RunOrder {
+    const SortPart* part;
+    RunOrder(const SortPart* part) : part(part) {}
+    bool operator()(const int a, const int b) const;
+  };
+
+  Status keep(int item, const Record & rec); // copy rec into buffer
+  Status select(const Record* rec);     // step of replacement selection
+  Status newRun(RUN & run, InsertFileScan*& out); // create a run file
+  Status mergePass(int count);          // merge first count runs into one
+  Status fetch(RUN & run);              // read next record of run
+  void closeRuns();                     // end scans, destroy run files
+
+  const SortedFile* sf;                 // the sort this is a part of
+
+  SORTREC* buffer;                      // in-memory sort buffer
+  char* space;                          // record copies of buffer
+  int slots;                            // # of records space has room for
+  int slotSize;                         // bytes of space per record
+  int maxItems;                         // max. # of items/tuples in buffer
+  int numItems;                         // current # of items in buffer
+
+  bool selecting;                       // TRUE once buffer has been full
+  LoserTree<RunOrder> heap;             // buffer during selection
+  InsertFileScan* out;                  // file of run being written
+  int current;                          // number of run being written
+
   vector<RUN> runs;                   // holds info about each sub-run
+  LoserTree<MergeOrder> tree;           // runs of the merge in next()
+  bool built;                           // FALSE if tree must be rebuilt
+  int last;                             // run of last record returned
+
+  bool inMemory;                        // TRUE if buffer holds all records
+  int pos;                              // next item of buffer to return
+  int markPos;                          // item returned again after gotoMark
+};
+
+
+// maxFrames limits the buffer frames the runs may keep pinned while
+// they are merged, two per run (0 for all frames unpinned when the
+// merge starts). If there are more runs than that, runs are merged
+// into longer ones in passes before next() merges the rest.
+//
+// With threads > 1 the sort is parallel: the key range is split into
+// as many parts, each sorted by a worker thread of its own with a
+// share of maxItems and maxFrames; next() returns the parts in order.
+
+class SortedFile {
+  friend class SortPart;
+
+ public:
+  SortedFile(const string & fileName, 
+	     int offset,// sort source file on the given
+	     int length, Datatype type, // attribute
+	     int maxItems, Status& status, int maxFrames = 0,
+	     int threads = 1);
+
+  Status next(Record & rec);            // fetch next record in sort order
+  Status setMark();                     // record a position in sort sequence
+  Status gotoMark();                    // go to last recorded spot
+  ~SortedFile();                        // destroy temporary structures / files
+
+ private:
+  Status sortFile();                    // sort source file into parts
+  Status splitKeys(int workers, vector<uint64_t> & splitters);
+  Status sortParts(Record & rec, const vector<uint64_t> & splitters,
+                   int frames);         // parallel
+  Status nextInput(Record & rec);       // next record of source file
+  string runName() const;               // name of a new run file
+
+  vector<SortPart*> parts;              // in key order
+  int cur;                              // part of last record returned
+  int markPart;                         // part of marked record
 
-  HeapFile* hfile;                   // source file to sort
   HeapFileScan* hfs;                   // source file to sort
+  RecordBatch batch;                    // records of current source page
+  int batchPos;                         // next record of batch
   string fileName;                      // name of source file to sort
+  int sortId;                           // distinguishes run file names
   Datatype type;                        // type of sort attribute
   int offset;                           // offset of sort attribute
   int length;                           // length of sort attribute
+  int tail;                             // bytes of it not in the key
+  int maxItems;                         // max. # of items/tuples in memory
+  int maxFrames;                        // frames for merging, 0 if all
+  int threads;                          // worker threads, 1 if serial
 
-  SORTREC* buffer;                      // in-memory sort buffer
-  int maxItems;                         // max. # of items/tuples in buffer
-  int numItems;                         // current # of items in buffer
+  mutable mutex latch;                  // protects runCnt
+  mutable int runCnt;                   // run files created so far
 };
 
 #endif
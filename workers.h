@@ -0,0 +1,47 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+using namespace std;
+
+// number of threads a parallel operator may use; 1 (the default) runs
+// every operator on the calling thread alone
+extern int QueryThreads;
+
+
+// Runs tasks 0..taskCnt-1 of a parallel operator on a pool of worker
+// threads. Tasks are started in the order of their numbers, each by
+// the first thread that is free, and the caller can wait for one task
+// while later ones are still running. The buffer manager and the
+// table of open files may be used by the tasks; anything else a task
+// touches must be its own or read-only while the pool runs.
+
+class WorkerPool
+{
+public:
+  WorkerPool(const int threads, const int taskCnt,
+	     const function<void (const int)> & task);
+  ~WorkerPool();                // tasks that have not been started are
+                                // skipped, running ones are waited for
+
+  void wait(const int i);       // until task i has finished
+  void waitAll();               // until every task has finished
+
+private:
+  function<void (const int)> task;
+  int taskCnt;
+  int next;                     // task to start next
+  bool stopping;                // start no more tasks
+  vector<bool> done;
+  mutex latch;                  // protects next, stopping and done
+  condition_variable finished;
+  vector<thread> threads;
+
+  void work();                  // body of a worker thread
+};
+
+#endif